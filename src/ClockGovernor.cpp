@@ -0,0 +1,108 @@
+#include "ClockGovernor.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+/**
+ * Reads the learned clock speeds. Each line is "<rom hash in hex> <clock speed>".
+ */
+static std::map<uint64_t, uint16_t> loadSettings(const std::string& settingsPath) {
+    std::map<uint64_t, uint16_t> settings;
+    std::ifstream file(settingsPath);
+    uint64_t romHash;
+    uint16_t clockSpeed;
+    while (file >> std::hex >> romHash >> std::dec >> clockSpeed) {
+        settings[romHash] = clockSpeed;
+    }
+    return settings;
+}
+
+/**
+ * If a clock speed was learned for this ROM before, we start from it. Otherwise we start from the initial clock speed.
+ * 
+ * @param const char* settingsPath - file where the learned clock speeds are stored, keyed by ROM hash
+ * @param const uint64_t romHash - hash of the loaded ROM, see Chip8::getRomHash()
+ * @param const uint16_t initialClockSpeed - clock speed to use if nothing was learned for this ROM
+ * @param const uint16_t minClockSpeed - the governor never goes below this, nor below 1 since the timers divide by the clock speed
+ * @param const uint16_t maxClockSpeed - the governor never goes above this
+ */
+ClockGovernor::ClockGovernor(const char* settingsPath, const uint64_t romHash, const uint16_t initialClockSpeed, const uint16_t minClockSpeed, const uint16_t maxClockSpeed)
+    : SETTINGS_PATH(settingsPath), ROM_HASH(romHash), MIN_CLOCK_SPEED(std::max<uint16_t>(1, minClockSpeed)), 
+    MAX_CLOCK_SPEED(std::max(MIN_CLOCK_SPEED, maxClockSpeed)), clockSpeed(initialClockSpeed), windowFrame(0), windowStartCycle(0), 
+    windowStartTimerWaitCycles(0), windowStartDelayTimerWrites(0) {
+    auto settings = loadSettings(SETTINGS_PATH);
+    if (settings.find(ROM_HASH) != settings.end()) {
+        clockSpeed = settings[ROM_HASH];
+    }
+    clockSpeed = std::clamp(clockSpeed, MIN_CLOCK_SPEED, MAX_CLOCK_SPEED);
+}
+
+uint16_t ClockGovernor::getClockSpeed() const {
+    return clockSpeed;
+}
+
+/**
+ * Called once after every frame. Every WINDOW_FRAMES frames the clock speed is adjusted based on the ratio of cycles 
+ * spent waiting for the delay timer.
+ * 
+ * Only windows where the game set the delay timer are used. A game that doesn't pace itself with the delay timer
+ * (or is sitting in a menu waiting for a key) runs at a speed set by the clock speed alone, so changing the clock 
+ * speed would change the game speed. Those windows leave the clock speed alone.
+ * 
+ * If a lot of the cycles were spent waiting for the timer the clock speed is lowered by 5%. If the game set the timer
+ * but hardly waited for it, it is not keeping up with emulated time and the clock speed is raised by 10%.
+ * Lowering slower than raising keeps the governor from oscillating around the lowest full speed clock speed.
+ * 
+ * @param const Chip8& chip8 - the emulator, after executing a frame
+ */
+void ClockGovernor::update(const Chip8& chip8) {
+    if (++windowFrame < WINDOW_FRAMES) {
+        return;
+    }
+
+    uint64_t cycles = chip8.getCycleCount() - windowStartCycle;
+    uint64_t timerWaitCycles = chip8.getTimerWaitCycles() - windowStartTimerWaitCycles;
+    uint64_t delayTimerWrites = chip8.getDelayTimerWrites() - windowStartDelayTimerWrites;
+    windowFrame = 0;
+    windowStartCycle = chip8.getCycleCount();
+    windowStartTimerWaitCycles = chip8.getTimerWaitCycles();
+    windowStartDelayTimerWrites = chip8.getDelayTimerWrites();
+    if (cycles == 0 || delayTimerWrites == 0) {
+        return;
+    }
+
+    activeClockSpeeds.push_back(clockSpeed);
+    double waitRatio = static_cast<double>(timerWaitCycles) / cycles;
+    if (waitRatio > HIGH_WAIT_RATIO) {
+        clockSpeed = std::max<int32_t>(MIN_CLOCK_SPEED, clockSpeed - std::max(clockSpeed / 20, 5));
+    } else if (waitRatio < LOW_WAIT_RATIO) {
+        clockSpeed = std::min<int32_t>(MAX_CLOCK_SPEED, clockSpeed + std::max(clockSpeed / 10, 10));
+    }
+}
+
+/**
+ * Stores the learned clock speed of this ROM, keeping the entries of other ROMs.
+ * The current clock speed depends on what the game was doing when it was closed, so instead a high percentile 
+ * of the clock speeds used while the game was active (setting the delay timer) is stored. 
+ * If the game was never active nothing is learned and the stored value is kept.
+ */
+void ClockGovernor::save() const {
+    if (activeClockSpeeds.empty()) {
+        return;
+    }
+    std::vector<uint16_t> clockSpeeds = activeClockSpeeds;
+    auto percentile = clockSpeeds.begin() + static_cast<size_t>((clockSpeeds.size() - 1) * SAVED_PERCENTILE);
+    std::nth_element(clockSpeeds.begin(), percentile, clockSpeeds.end());
+
+    auto settings = loadSettings(SETTINGS_PATH);
+    settings[ROM_HASH] = *percentile;
+
+    std::ofstream file(SETTINGS_PATH);
+    if (!file) {
+        throw std::runtime_error("Could not write clock speed settings to " + SETTINGS_PATH);
+    }
+    for (const auto& [romHash, learnedClockSpeed] : settings) {
+        file << std::hex << romHash << " " << std::dec << learnedClockSpeed << std::endl;
+    }
+}
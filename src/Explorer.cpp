@@ -0,0 +1,194 @@
+#include "Explorer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+TranspositionTable::TranspositionTable(const size_t maxEntries) : MAX_ENTRIES_PER_SHARD(std::max<size_t>(1, maxEntries / SHARD_COUNT)) {}
+
+/**
+ * @returns true if the hash was not in the table before. When a shard is full new hashes are not stored,
+ * so those states are not pruned if they come up again, but the memory budget is kept.
+ */
+bool TranspositionTable::insert(const uint64_t hash) {
+    // The low bits pick the bucket inside the set, so the high bits pick the shard
+    Shard& shard = shards[hash >> 58];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.hashes.find(hash) != shard.hashes.end()) {
+        return false;
+    }
+    if (shard.hashes.size() < MAX_ENTRIES_PER_SHARD) {
+        shard.hashes.insert(hash);
+    }
+    return true;
+}
+
+size_t TranspositionTable::size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards) {
+        size += shard.hashes.size();
+    }
+    return size;
+}
+
+/**
+ * @param const Chip8& initialState - the state the search starts from, e.g. right after loading the ROM
+ * @param const std::vector<int>& keys - keys to branch on. Pressing nothing is always tried as well.
+ * @param const uint32_t framesPerStep - how many frames a key is held for before branching again
+ * @param const size_t beamWidth - states kept every step, 0 keeps as many as the memory budget allows
+ * @param const size_t memoryBudget - bytes the frontier, the path history and the transposition table may use, roughly
+ * @param const unsigned int threadCount - number of worker threads that expand the frontier
+ * @param const ScoreFunction& score - used to pick the states kept by the beam. Without it states are kept by hash order.
+ */
+Explorer::Explorer(const Chip8& initialState, const std::vector<int>& keys, const uint32_t framesPerStep, const size_t beamWidth,
+    const size_t memoryBudget, const unsigned int threadCount, const ScoreFunction& score)
+    : KEYS(keys), FRAMES_PER_STEP(std::max<uint32_t>(1, framesPerStep)),
+    // 3/4 of the budget is for states and their history. Every state in the frontier can have a child for every key, plus pressing nothing.
+    STATE_MEMORY(memoryBudget * 3 / 4),
+    MAX_FRONTIER_SIZE(std::max<size_t>(1, std::min(beamWidth == 0 ? SIZE_MAX : beamWidth, STATE_MEMORY / ((keys.size() + 2) * sizeof(Node))))),
+    THREAD_COUNT(std::max(1u, threadCount)), SCORE(score),
+    // The rest is for the table. An unordered_set entry is about 32 bytes.
+    table(memoryBudget / 4 / 32),
+    depth(0), bestScore(0), bestHistoryIndex(0), deepestHistoryIndex(0) {
+    Node root = { initialState, initialState.hashState(), 0, 0 };
+    root.state.setTracer(nullptr);
+    root.score = SCORE ? SCORE(root.state) : 0;
+    bestScore = root.score;
+    table.insert(root.hash);
+    history.push_back({ NO_PARENT, NO_KEY });
+    frontier.push_back(root);
+}
+
+/**
+ * Runs a copy of the parent for FRAMES_PER_STEP frames with the key held down. 
+ * The copy is kept if it reached a state that was not seen before. States where the ROM crashed are dropped.
+ */
+void Explorer::expand(const Node& parent, const int key, std::vector<Node>& children, std::vector<int>& childKeys, std::vector<uint32_t>& childParents) {
+    Node child = parent;
+    std::fill(std::begin(child.state.keyboard), std::end(child.state.keyboard), false);
+    if (key != NO_KEY) {
+        child.state.keyboard[key] = true;
+    }
+    try {
+        for (uint32_t i = 0; i < FRAMES_PER_STEP; i++) {
+            child.state.executeFrame();
+        }
+    } catch (const std::exception&) {
+        return;
+    }
+
+    child.hash = child.state.hashState();
+    if (!table.insert(child.hash)) {
+        return;
+    }
+    child.score = SCORE ? SCORE(child.state) : 0;
+    childParents.push_back(parent.historyIndex);
+    childKeys.push_back(key);
+    children.push_back(std::move(child));
+}
+
+/**
+ * Expands the whole frontier by one step on THREAD_COUNT threads, then keeps the best MAX_FRONTIER_SIZE new states.
+ * The history grows by one entry for every kept state and is never freed, so it takes its share of the state memory
+ * and the frontier shrinks as the search gets deeper.
+ * 
+ * @returns false if there are no new states left to explore, or the history used up the memory budget
+ */
+bool Explorer::step() {
+    if (frontier.empty()) {
+        return false;
+    }
+
+    struct WorkerResult {
+        std::vector<Node> children;
+        std::vector<int> keys;
+        std::vector<uint32_t> parents;
+    };
+    std::vector<WorkerResult> results(THREAD_COUNT);
+    std::atomic<size_t> nextNode = 0;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < THREAD_COUNT; t++) {
+        workers.emplace_back([this, t, &results, &nextNode]() {
+            WorkerResult& result = results[t];
+            for (size_t i = nextNode++; i < frontier.size(); i = nextNode++) {
+                expand(frontier[i], NO_KEY, result.children, result.keys, result.parents);
+                for (int key : KEYS) {
+                    expand(frontier[i], key, result.children, result.keys, result.parents);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Keep the best scoring children, ties are broken by hash so the kept states don't depend on which thread found them
+    std::vector<std::pair<unsigned int, size_t>> order;
+    for (unsigned int t = 0; t < THREAD_COUNT; t++) {
+        for (size_t i = 0; i < results[t].children.size(); i++) {
+            order.push_back({ t, i });
+        }
+    }
+    auto isBetter = [&results](const std::pair<unsigned int, size_t>& a, const std::pair<unsigned int, size_t>& b) {
+        const Node& nodeA = results[a.first].children[a.second];
+        const Node& nodeB = results[b.first].children[b.second];
+        return nodeA.score != nodeB.score ? nodeA.score > nodeB.score : nodeA.hash < nodeB.hash;
+    };
+    size_t historyMemory = history.capacity() * sizeof(History);
+    size_t maxFrontierSize = historyMemory >= STATE_MEMORY ? 0 
+        : std::min(MAX_FRONTIER_SIZE, (STATE_MEMORY - historyMemory) / ((KEYS.size() + 2) * sizeof(Node) + sizeof(History)));
+    if (order.size() > maxFrontierSize) {
+        std::nth_element(order.begin(), order.begin() + maxFrontierSize, order.end(), isBetter);
+        order.resize(maxFrontierSize);
+    }
+    std::sort(order.begin(), order.end(), isBetter);
+
+    std::vector<Node> nextFrontier;
+    nextFrontier.reserve(order.size());
+    for (const auto& [t, i] : order) {
+        Node& child = results[t].children[i];
+        child.historyIndex = history.size();
+        history.push_back({ results[t].parents[i], static_cast<int8_t>(results[t].keys[i]) });
+        if (child.score > bestScore) {
+            bestScore = child.score;
+            bestHistoryIndex = child.historyIndex;
+        }
+        nextFrontier.push_back(std::move(child));
+    }
+    if (!nextFrontier.empty()) {
+        deepestHistoryIndex = nextFrontier.front().historyIndex;
+    }
+    frontier = std::move(nextFrontier);
+    ++depth;
+    return !frontier.empty();
+}
+
+uint32_t Explorer::getDepth() const {
+    return depth;
+}
+
+size_t Explorer::getFrontierSize() const {
+    return frontier.size();
+}
+
+size_t Explorer::getUniqueStates() const {
+    return table.size();
+}
+
+double Explorer::getBestScore() const {
+    return bestScore;
+}
+
+/**
+ * Without a score function every state scores the same, so the path to a state of the deepest frontier is returned.
+ * 
+ * @returns the key held during every step (NO_KEY for nothing) to reach the best scoring state
+ */
+std::vector<int> Explorer::getBestPath() const {
+    uint32_t index = SCORE ? bestHistoryIndex : deepestHistoryIndex;
+    std::vector<int> path;
+    for (; history[index].parent != NO_PARENT; index = history[index].parent) {
+        path.push_back(history[index].key);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,159 @@
+#include "GridRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Colors are ARGB8888, the format of the atlas texture
+static const uint32_t BACKGROUND_COLOR = 0xFF000000;
+static const uint32_t GAP_COLOR = 0xFF303030;
+static const uint32_t PIXEL_COLOR = 0xFFFFFFFF;
+static const uint32_t STALLED_PIXEL_COLOR = 0xFFFF4040;
+static const uint32_t FPS_BAR_COLOR = 0xFF40C040;
+static const uint32_t IPS_BAR_COLOR = 0xFF4080FF;
+static const uint32_t STALLED_BAR_COLOR = 0xFFFF0000;
+
+/**
+ * Creates a window that shows the displays of tileCount emulators in a grid.
+ * All displays are composited into one texture (the atlas), so every frame needs a single texture upload and a single draw call
+ * no matter how many emulators there are. The number of columns is picked so that the grid has about the aspect ratio of the window.
+ * 
+ * @param const double targetFps - fps at which the fps bar of a tile is full
+ * @param const double targetInstructionsPerSecond - instructions per second at which the ips bar of a tile is full
+ */
+GridRenderer::GridRenderer(const char* title, const int tileCount, const int windowWidth, const int windowHeight, const double targetFps, const double targetInstructionsPerSecond)
+    : window(nullptr), renderer(nullptr), atlas(nullptr), isRunning(false), TILE_COUNT(tileCount),
+    COLUMNS(std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tileCount) * windowWidth * TILE_HEIGHT / (windowHeight * TILE_WIDTH)))))), ROWS(std::max(1, (tileCount + COLUMNS - 1) / COLUMNS)),
+    TARGET_FPS(targetFps), TARGET_INSTRUCTIONS_PER_SECOND(targetInstructionsPerSecond),
+    pixels(COLUMNS * TILE_WIDTH * ROWS * TILE_HEIGHT, GAP_COLOR), focusedTile(NO_TILE) {
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    window = SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, windowWidth, windowHeight, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+    if (window == nullptr) {
+        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (renderer == nullptr) {
+        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    // Nearest neighbour scaling, so the pixels stay sharp
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+    atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, COLUMNS * TILE_WIDTH, ROWS * TILE_HEIGHT);
+    if (atlas == nullptr) {
+        std::cerr << "Texture could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return;
+    }
+    isRunning = true;
+}
+
+GridRenderer::~GridRenderer() {
+    SDL_DestroyTexture(atlas);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+const bool GridRenderer::checkRunning() {
+    return isRunning;
+}
+
+int GridRenderer::getFocusedTile() const {
+    return focusedTile;
+}
+
+/**
+ * Handles the close event and focusing. Clicking a tile shows only that tile, clicking again or pressing escape 
+ * goes back to the grid.
+ */
+void GridRenderer::handleEvents() {
+    SDL_Event event;
+    while (SDL_PollEvent(&event) != 0) {
+        if (event.type == SDL_QUIT) {
+            isRunning = false;
+        } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) {
+            focusedTile = NO_TILE;
+        } else if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
+            if (focusedTile != NO_TILE) {
+                focusedTile = NO_TILE;
+                continue;
+            }
+            SDL_Rect grid = getDestinationRect({ 0, 0, COLUMNS * TILE_WIDTH, ROWS * TILE_HEIGHT });
+            if (event.button.x >= grid.w || event.button.y >= grid.h) {
+                continue;
+            }
+            int column = event.button.x * COLUMNS / grid.w;
+            int row = event.button.y * ROWS / grid.h;
+            int tile = row * COLUMNS + column;
+            if (tile < TILE_COUNT) {
+                focusedTile = tile;
+            }
+        }
+    }
+}
+
+SDL_Rect GridRenderer::getTileRect(const int tile) const {
+    return { (tile % COLUMNS) * TILE_WIDTH, (tile / COLUMNS) * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT };
+}
+
+/**
+ * Scales the source rectangle to fit the window, keeping the aspect ratio.
+ */
+SDL_Rect GridRenderer::getDestinationRect(const SDL_Rect& source) const {
+    int windowWidth;
+    int windowHeight;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    double scale = std::min(static_cast<double>(windowWidth) / source.w, static_cast<double>(windowHeight) / source.h);
+    return { 0, 0, static_cast<int>(source.w * scale), static_cast<int>(source.h * scale) };
+}
+
+/**
+ * Draws a 64 pixel wide status bar, filled up to the fraction.
+ */
+void GridRenderer::drawBar(const int x, const int y, const double fraction, const uint32_t color) {
+    const int atlasWidth = COLUMNS * TILE_WIDTH;
+    int filled = static_cast<int>(std::clamp(fraction, 0.0, 1.0) * 64);
+    uint32_t* row = &pixels[y * atlasWidth + x];
+    std::fill(row, row + filled, color);
+    std::fill(row + filled, row + 64, BACKGROUND_COLOR);
+}
+
+/**
+ * Copies the emulated display of one emulator into its tile, and draws its status bars below it.
+ * Only writes to memory, nothing is sent to the GPU until render() is called.
+ * 
+ * @param const int tile - index of the emulator
+ * @param const bool display[64][32] - the emulated display signal, see Chip8::getDisplay()
+ * @param const TileStatus& status - shown as a fps bar, an ips bar, and red pixels if the emulator stalled
+ */
+void GridRenderer::updateTile(const int tile, const bool display[64][32], const TileStatus& status) {
+    const int atlasWidth = COLUMNS * TILE_WIDTH;
+    SDL_Rect rect = getTileRect(tile);
+    uint32_t pixelColor = status.stalled ? STALLED_PIXEL_COLOR : PIXEL_COLOR;
+    for (int i = 0; i < 32; i++) {
+        uint32_t* row = &pixels[(rect.y + i) * atlasWidth + rect.x];
+        for (int j = 0; j < 64; j++) {
+            row[j] = display[j][i] ? pixelColor : BACKGROUND_COLOR;
+        }
+    }
+    drawBar(rect.x, rect.y + 32, status.stalled ? 1 : status.fps / TARGET_FPS, status.stalled ? STALLED_BAR_COLOR : FPS_BAR_COLOR);
+    drawBar(rect.x, rect.y + 33, status.instructionsPerSecond / TARGET_INSTRUCTIONS_PER_SECOND, IPS_BAR_COLOR);
+}
+
+/**
+ * Uploads the atlas once and draws either the whole grid or only the focused tile, keeping the aspect ratio.
+ */
+void GridRenderer::render() {
+    SDL_UpdateTexture(atlas, nullptr, pixels.data(), COLUMNS * TILE_WIDTH * sizeof(uint32_t));
+
+    SDL_Rect source = focusedTile == NO_TILE ? SDL_Rect{ 0, 0, COLUMNS * TILE_WIDTH, ROWS * TILE_HEIGHT } : getTileRect(focusedTile);
+    SDL_Rect destination = getDestinationRect(source);
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, atlas, &source, &destination);
+    SDL_RenderPresent(renderer);
+}
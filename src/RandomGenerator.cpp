@@ -0,0 +1,89 @@
+#include "RandomGenerator.hpp"
+#include <random>
+#include <stdexcept>
+#include <string>
+
+RandomGenerator::RandomGenerator(const uint64_t seed, const Mode mode) : mode(mode), state(0), buffer{}, position(BUFFER_SIZE) {
+    this -> seed(seed);
+}
+
+/**
+ * xorshift64* must never have a state of 0, so the seed is scrambled with splitmix64 first.
+ * That also makes seeds that are close together (0, 1, 2...) produce unrelated sequences.
+ * 
+ * @param const uint64_t seed - the same seed always produces the same bytes
+ */
+void RandomGenerator::seed(const uint64_t seed) {
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    state = z != 0 ? z : 0x9e3779b97f4a7c15ULL;
+    // Throw away whatever was generated with the old seed
+    position = BUFFER_SIZE;
+}
+
+void RandomGenerator::setMode(const Mode mode) {
+    this -> mode = mode;
+    position = BUFFER_SIZE;
+}
+
+RandomGenerator::Mode RandomGenerator::getMode() const {
+    return mode;
+}
+
+/**
+ * The mode, the state and the position in the buffer decide every byte that will be generated,
+ * so two generators with the same mode, state and position produce the same bytes from here on.
+ */
+uint64_t RandomGenerator::getState() const {
+    return state;
+}
+
+size_t RandomGenerator::getPosition() const {
+    return position;
+}
+
+/**
+ * @param const char* name - "xorshift" or "legacy"
+ */
+RandomGenerator::Mode RandomGenerator::parseMode(const char* name) {
+    std::string mode = name;
+    if (mode == "xorshift") {
+        return Mode::XORSHIFT;
+    }
+    if (mode == "legacy") {
+        return Mode::LEGACY;
+    }
+    throw std::runtime_error("Unknown random generator: " + mode + ". Use xorshift or legacy.");
+}
+
+/**
+ * Fills the whole buffer. xorshift64* gives 8 bytes per step.
+ * In LEGACY mode every byte is drawn from a std::mt19937 through uniform_int_distribution(0, 255), like the emulator used to.
+ * The mt19937 is seeded from the state (advanced like splitmix64) every refill instead of being kept, 
+ * so the generator stays small to copy and the state still decides every byte.
+ */
+void RandomGenerator::refill() {
+    if (mode == Mode::LEGACY) {
+        state += 0x9e3779b97f4a7c15ULL;
+        std::seed_seq seedSequence = { static_cast<uint32_t>(state), static_cast<uint32_t>(state >> 32) };
+        std::mt19937 generator(seedSequence);
+        std::uniform_int_distribution<> distribution(0, 255);
+        for (size_t i = 0; i < BUFFER_SIZE; i++) {
+            buffer[i] = distribution(generator);
+        }
+    } else {
+        for (size_t i = 0; i < BUFFER_SIZE; i += 8) {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            uint64_t value = state * 0x2545f4914f6cdd1dULL;
+            // Highest byte first, so a seed produces the same bytes on every platform
+            for (size_t j = 0; j < 8; j++) {
+                buffer[i + j] = value >> (56 - 8 * j);
+            }
+        }
+    }
+    position = 0;
+}
@@ -0,0 +1,88 @@
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Opens the trace file and starts the thread that writes the recorded instructions to it.
+ * 
+ * @param const char* filePath - the file to write the trace to. It is overwritten if it exists.
+ * @param const size_t capacity - number of records the ring buffer can hold. Rounded up to a power of 2.
+ */
+TraceRecorder::TraceRecorder(const char* filePath, const size_t capacity)
+    : ring(std::bit_ceil(capacity)), mask(std::bit_ceil(capacity) - 1), head(0), tail(0), droppedRecords(0), isRunning(true),
+    file(filePath, std::ios::binary) {
+    if (!file) {
+        throw std::runtime_error("Could not open trace file for writing.");
+    }
+
+    TraceFileHeader header;
+    std::memcpy(header.magic, TraceFileHeader::MAGIC, sizeof(header.magic));
+    header.version = TraceFileHeader::VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.droppedRecords = 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    // Flushed right away, so even a trace that ends in a crash can be recognised as one
+    file.flush();
+
+    flushThread = std::thread(&TraceRecorder::flushLoop, this);
+}
+
+/**
+ * Stops the flush thread, writes whatever is left in the ring buffer and stores the number of dropped records in the header.
+ */
+TraceRecorder::~TraceRecorder() {
+    isRunning.store(false, std::memory_order_release);
+    flushThread.join();
+    flush();
+    uint64_t dropped = getDroppedRecords();
+    file.seekp(offsetof(TraceFileHeader, droppedRecords));
+    file.write(reinterpret_cast<const char*>(&dropped), sizeof(dropped));
+    file.close();
+
+    if (getDroppedRecords() > 0) {
+        std::cerr << "Trace ring buffer was full, dropped " << getDroppedRecords() << " records." << std::endl;
+    }
+}
+
+uint64_t TraceRecorder::getDroppedRecords() const {
+    return droppedRecords.load(std::memory_order_relaxed);
+}
+
+/**
+ * Writes everything recorded since the last flush with at most two writes (the ring buffer might wrap around).
+ * 
+ * @returns true if anything was written
+ */
+bool TraceRecorder::flush() {
+    size_t tail = this -> tail.load(std::memory_order_relaxed);
+    size_t head = this -> head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    size_t start = tail & mask;
+    size_t count = head - tail;
+    size_t firstChunk = std::min(count, ring.size() - start);
+    file.write(reinterpret_cast<const char*>(&ring[start]), firstChunk * sizeof(TraceRecord));
+    file.write(reinterpret_cast<const char*>(&ring[0]), (count - firstChunk) * sizeof(TraceRecord));
+
+    // Only now can the emulator reuse the slots
+    this -> tail.store(head, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Runs on the flush thread. Sleeps while there is nothing to write so the emulator never has to signal it.
+ */
+void TraceRecorder::flushLoop() {
+    while (isRunning.load(std::memory_order_acquire)) {
+        if (!flush()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
@@ -1,14 +1,18 @@
 #include "Chip8.hpp"
+#include "TraceRecorder.hpp"
 #include <fstream>
 #include <iostream>
 #include <filesystem>
 #include <thread>
 #include <chrono>
 #include <random>
+#include <algorithm>
+#include <cstring>
 
 Chip8::Chip8() : pc(0x200), opcode(0), memory{}, dataRegisters{}, addressRegister(0), memoryStack{},
-stackPointer(0), delayTimer(0), soundTimer(0), display{}, keyboard{}, drawFlag(false), 
-processorClockSpeed(700), timerPrecision(1000), fps(60), timerFrequency(60) {}
+stackPointer(0), delayTimer(0), soundTimer(0), delayTimerSetCycle(0), soundTimerSetCycle(0), cycleCount(0),
+cycleRemainder(0), display{}, keyboard{}, drawFlag(false), processorClockSpeed(700), fps(60), timerFrequency(60),
+tracer(nullptr), randomGenerator(std::random_device()()), timerWaitCycles(0), delayTimerWrites(0), timerReadCycle(0), timerReadPc(0), jumpCycle(0), romHash(0) {}
 
 Chip8::~Chip8() {}
 
@@ -22,13 +26,20 @@ const bool (&Chip8::getDisplay() const)[64][32] {
     return display;
 }
 
+/**
+ * @returns the emulated memory, e.g. to read the score of a game
+ */
+const uint8_t (&Chip8::getMemory() const)[4096] {
+    return memory;
+}
+
 /**
  * Chip8 produced beep sound when the sound timer was non zero.
  * 
  * @returns true if a beep sound should be produced, false otherwise. 
  */
 bool Chip8::shouldBeep() const {
-    return soundTimer != 0;
+    return getTimerValue(soundTimer, soundTimerSetCycle) != 0;
 }
 
 /**
@@ -59,9 +70,132 @@ uint16_t Chip8::getProcessorClockSpeed() const {
 };
 
 void Chip8::setProcessorClockSpeed(const uint16_t clockSpeed) {
+    // Timers are derived from the cycle counter, so they have to be rebased before the clock speed changes.
+    if (clockSpeed != processorClockSpeed) {
+        rebaseTimer(delayTimer, delayTimerSetCycle, clockSpeed);
+        rebaseTimer(soundTimer, soundTimerSetCycle, clockSpeed);
+    }
     this -> processorClockSpeed = clockSpeed;
 };
 
+uint64_t Chip8::getCycleCount() const {
+    return cycleCount;
+}
+
+/**
+ * Number of cycles spent in loops polling the delay timer (a short loop that reads the delay timer and jumps back).
+ * Only games that pace themselves with the delay timer have these. A high ratio means the processor clock speed
+ * could be lowered without slowing the game down, and if such a game stops having them it is running slower than it should.
+ * 
+ * @returns the number of cycles spent waiting for the delay timer since the start
+ */
+uint64_t Chip8::getTimerWaitCycles() const {
+    return timerWaitCycles;
+}
+
+/**
+ * @returns the number of times the delay timer was set (FX15) since the start
+ */
+uint64_t Chip8::getDelayTimerWrites() const {
+    return delayTimerWrites;
+}
+
+/**
+ * @returns the 64 bit FNV-1a hash of the loaded ROM, can be used to identify the ROM
+ */
+uint64_t Chip8::getRomHash() const {
+    return romHash;
+}
+
+/**
+ * Every executed instruction will be recorded to the provided tracer. The tracer is not owned by the emulator
+ * and must outlive it. Pass nullptr to stop tracing.
+ * 
+ * @param TraceRecorder* tracer - the tracer to record to
+ */
+void Chip8::setTracer(TraceRecorder* tracer) {
+    this -> tracer = tracer;
+}
+
+/**
+ * Makes CXNN reproducible. Every instance is seeded from std::random_device when it is created, 
+ * seeding it with the same value makes it produce the same random numbers every run.
+ * 
+ * @param const uint64_t seed - the seed
+ */
+void Chip8::seedRandom(const uint64_t seed) {
+    randomGenerator.seed(seed);
+}
+
+void Chip8::setRandomMode(const RandomGenerator::Mode mode) {
+    randomGenerator.setMode(mode);
+}
+
+/**
+ * Records the instruction that was just executed. The changed register is found by comparing the data registers
+ * to their values before the instruction. If more than one changed (e.g. 8XY4 also sets VF), the lowest index is recorded.
+ * 
+ * @param const uint16_t tracedPc - the pc the instruction was read from
+ * @param const uint8_t (&tracedRegisters)[16] - the data registers before the instruction was executed
+ */
+void Chip8::recordTrace(const uint16_t tracedPc, const uint8_t (&tracedRegisters)[16]) {
+    TraceRecord record = { cycleCount, tracedPc, opcode, addressRegister, TraceRecord::NO_REGISTER, 0 };
+    for (uint8_t i = 0; i < 16; i++) {
+        if (dataRegisters[i] != tracedRegisters[i]) {
+            record.changedRegister = i;
+            record.registerValue = dataRegisters[i];
+            break;
+        }
+    }
+    tracer -> record(record);
+}
+
+/**
+ * Hashes the emulated machine state (memory, registers, stack, timers, display and random generator).
+ * The timers are hashed with how far they are into their current tick, and the cycles carried over to the next frame
+ * are hashed as well, so that states which only differ in when the next timer tick or frame happens are told apart.
+ * Two instances that return the same hash will behave the same from here on, given the same input, clock speed and fps.
+ * The state is about 6KB and is hashed often when exploring, so it is mixed 8 bytes at a time 
+ * (multiply and xorshift) instead of byte by byte.
+ * 
+ * @returns the hash of the current state
+ */
+uint64_t Chip8::hashState() const {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+            hash ^= hash >> 29;
+        }
+        for (; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+        }
+    };
+    uint8_t timers[2] = { getTimerValue(delayTimer, delayTimerSetCycle), getTimerValue(soundTimer, soundTimerSetCycle) };
+    // How far a running timer is into its current tick decides on which cycle it ticks next, a stopped timer has no phase
+    auto timerPhase = [this](const uint8_t value, const uint64_t setCycle) -> uint64_t {
+        return getTimerValue(value, setCycle) == 0 ? 0 : ((cycleCount - setCycle) * timerFrequency) % processorClockSpeed;
+    };
+    uint64_t phases[3] = { timerPhase(delayTimer, delayTimerSetCycle), timerPhase(soundTimer, soundTimerSetCycle), cycleRemainder };
+    mix(memory, sizeof(memory));
+    mix(dataRegisters, sizeof(dataRegisters));
+    mix(memoryStack, sizeof(memoryStack));
+    mix(&stackPointer, sizeof(stackPointer));
+    mix(&pc, sizeof(pc));
+    mix(&addressRegister, sizeof(addressRegister));
+    mix(timers, sizeof(timers));
+    mix(phases, sizeof(phases));
+    mix(display, sizeof(display));
+    // CXNN is reproducible, so states that only differ in the random generator behave differently at the next CXNN
+    uint64_t random[2] = { randomGenerator.getState(), randomGenerator.getPosition() };
+    mix(random, sizeof(random));
+    return hash;
+}
+
 /**
  * Loads the file present in the provided file path.
  * 
@@ -112,6 +246,11 @@ void Chip8::loadFile(const char* filePath) {
         throw std::runtime_error("Could not load file to memory");
     }
     file.close();
+
+    romHash = 0xcbf29ce484222325ULL;
+    for (std::uintmax_t i = 0; i < fileSize; i++) {
+        romHash = (romHash ^ memory[0x200 + i]) * 0x100000001b3ULL;
+    }
 }
 
 /**
@@ -146,13 +285,9 @@ void Chip8::throwOpcodeNotRecognisedError(const uint16_t opcode) {
  * Generates a random number between 0 and 255
  */
 uint8_t Chip8::getRandomNumber() {
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_int_distribution<> distribution(0, 255);
-    return distribution(generator);
+    return randomGenerator.next();
 }
 
-
 /**
  * Update emulated display signals
  * 
@@ -214,42 +349,111 @@ void Chip8::storeKey(uint8_t x) {
 }
 
 /**
- * Chip8 timers ticked at a frequency of 60 hz.This function is called once every frame. 
- * Since FPS is frames per second, frequency/fps is the amount we want to tick. However it might be less than 1.
- * timerPrecision is used as a multiplier so that we can update the timer bit by bit instead of reducing by 1 every 1/60 second,
- * this makes the tick greater than 1. Doubles/floats could also be used instead. 
+ * Jump to the address (1NNN). Also detects the loops games use to wait for the delay timer, so that those cycles can be counted.
+ * Such a loop is a short backward jump over a delay timer read (FX07) that happened a few cycles ago,
+ * since the loop is polling the timer (and maybe the keys). Every instruction of such a loop is counted as waiting.
+ * 
+ * @param uint16_t address - the address to jump to
+ */
+void Chip8::jump(uint16_t address) {
+    uint16_t jumpPc = pc - 2;
+    if (address <= timerReadPc && timerReadPc < jumpPc && jumpPc - address <= 32 && cycleCount - timerReadCycle <= 4) {
+        // Instructions skipped inside the loop were not executed, so never count more than the cycles since the last jump
+        uint64_t loopCycles = std::min<uint64_t>((jumpPc - address) / 2 + 1, cycleCount - jumpCycle);
+        timerWaitCycles += loopCycles;
+    }
+    jumpCycle = cycleCount;
+    pc = address;
+}
+
+/**
+ * Chip8 timers ticked at a frequency of 60 hz. Instead of decrementing them every frame, we store the value that was
+ * written to the timer and the cycle at which it was written. The current value is derived from the number of emulated 
+ * cycles that have passed since then, so the timers tick at exactly 60 hz of emulated time regardless of fps.
+ * 
+ * @param const uint8_t value - the value that was written to the timer
+ * @param const uint64_t setCycle - the cycle at which the value was written
+ * @returns the current value of the timer
+ */
+uint8_t Chip8::getTimerValue(const uint8_t value, const uint64_t setCycle) const {
+    if (value == 0) {
+        return 0;
+    }
+    uint64_t ticks = (cycleCount - setCycle) * timerFrequency / processorClockSpeed;
+    return ticks >= value ? 0 : value - ticks;
+}
+
+/**
+ * Converts a timer to the new clock speed. The current value is stored along with how far into the current tick we are,
+ * so that changing the clock speed does not make the timer gain or lose time.
+ * 
+ * @param uint8_t& value - the stored timer value, updated to the current value
+ * @param uint64_t& setCycle - the stored timer cycle, updated to match the new clock speed
+ * @param const uint16_t newClockSpeed - the clock speed that will be used from now on
  */
-void Chip8::updateTimers() {
-    uint16_t ticks = (timerPrecision * timerFrequency) / fps;
-    if (delayTimer > 0) {
-       delayTimer = delayTimer >= ticks ? delayTimer - ticks : 0;
-    }   
-   
-    if (soundTimer > 0) {
-       soundTimer = soundTimer >= ticks ? soundTimer - ticks : 0;
+void Chip8::rebaseTimer(uint8_t& value, uint64_t& setCycle, const uint16_t newClockSpeed) {
+    uint8_t current = getTimerValue(value, setCycle);
+    if (current == 0) {
+        value = 0;
+        setCycle = cycleCount;
+        return;
     }
+    // Fraction of the current tick that has passed, in units of 1/(processorClockSpeed) ticks
+    uint64_t partialTick = ((cycleCount - setCycle) * timerFrequency) % processorClockSpeed;
+    uint64_t partialCycles = partialTick * newClockSpeed / (static_cast<uint64_t>(processorClockSpeed) * timerFrequency);
+    value = current;
+    setCycle = cycleCount - std::min(partialCycles, cycleCount);
 }
 
 /**
  * Execute 1 frame. If there are fps frames in 1 second, and processor clock speed is processorClockSpeed
  * processorClockSpeed/fps cycles needs to be executed.
- * Update the timers after the executon.
+ * The remainder of the division is carried over to the next frame so that exactly processorClockSpeed cycles 
+ * are executed every second. Timers are derived from the cycle count, so they need no update here.
  */
 void Chip8::executeFrame() {
-    for(uint32_t i = 0; i < processorClockSpeed/fps ; i++) {
+    uint32_t cycles = (processorClockSpeed + cycleRemainder) / fps;
+    cycleRemainder = (processorClockSpeed + cycleRemainder) % fps;
+    for(uint32_t i = 0; i < cycles ; i++) {
         executeOneCycle();
     }
-    updateTimers();
 }
 
 /**
  * Execute 1 processor cycle. 
- * 
- * Todo: add documentation on opcodes. 
+ * When tracing, the instruction is recorded even if it throws, so the trace ends with the faulting instruction.
  */
 void Chip8::executeOneCycle() {
+    // Only needed when tracing, to find out which register the instruction changed
+    uint16_t tracedPc = pc;
+    uint8_t tracedRegisters[16];
+    if (tracer != nullptr) {
+        std::copy(std::begin(dataRegisters), std::end(dataRegisters), tracedRegisters);
+    }
+
     readOpcode();
-    
+    ++cycleCount;
+
+    try {
+        executeOpcode();
+    } catch (...) {
+        if (tracer != nullptr) {
+            recordTrace(tracedPc, tracedRegisters);
+        }
+        throw;
+    }
+
+    if (tracer != nullptr) {
+        recordTrace(tracedPc, tracedRegisters);
+    }
+}
+
+/**
+ * Execute the opcode that was just read. 
+ * 
+ * Todo: add documentation on opcodes. 
+ */
+void Chip8::executeOpcode() {
     switch (opcode >> 12) {
         case 0x0:
             switch (opcode & 0x0FFF) {
@@ -269,7 +473,7 @@ void Chip8::executeOneCycle() {
             }
             break;
         case 0x1: 
-            pc = opcode & 0x0FFF;
+            jump(opcode & 0x0FFF);
             break;
         case 0x2: 
             memoryStack[stackPointer] = pc;
@@ -390,16 +594,21 @@ void Chip8::executeOneCycle() {
         case 0xF: 
             switch (opcode & 0x00FF) {
                 case 0x07:
-                    dataRegisters[(opcode & 0x0F00) >> 8] = delayTimer / timerPrecision;
+                    dataRegisters[(opcode & 0x0F00) >> 8] = getTimerValue(delayTimer, delayTimerSetCycle);
+                    timerReadPc = pc - 2;
+                    timerReadCycle = cycleCount;
                     break;
                 case 0x0A:
                     storeKey((opcode & 0x0F00) >> 8);
                     break;
                 case 0x15:
-                    delayTimer = dataRegisters[(opcode & 0x0F00) >> 8] * timerPrecision;
+                    delayTimer = dataRegisters[(opcode & 0x0F00) >> 8];
+                    delayTimerSetCycle = cycleCount;
+                    ++delayTimerWrites;
                     break;
                 case 0x18:
-                    soundTimer = dataRegisters[(opcode & 0x0F00) >> 8] * timerPrecision;
+                    soundTimer = dataRegisters[(opcode & 0x0F00) >> 8];
+                    soundTimerSetCycle = cycleCount;
                     break;
                 case 0x1E:
                     addressRegister += dataRegisters[(opcode & 0x0F00) >> 8];
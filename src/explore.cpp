@@ -0,0 +1,109 @@
+#include "Explorer.hpp"
+#include "utils.hpp"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+/**
+ * Parses a comma separated list of keys, e.g. "4,6" or "0x4,0x6".
+ */
+std::vector<int> parseKeys(const std::string& value) {
+    std::vector<int> keys;
+    std::istringstream stream(value);
+    std::string key;
+    while (std::getline(stream, key, ',')) {
+        int parsed = std::stoi(key, nullptr, 0);
+        if (parsed < 0 || parsed > 0xF) {
+            throw std::runtime_error("Keys must be between 0x0 and 0xF.");
+        }
+        keys.push_back(parsed);
+    }
+    return keys;
+}
+
+/**
+ * Searches over input sequences of a ROM to reach new game states quickly.
+ * Every step branches on the key set, runs every branch for a number of frames and prunes states that were seen before.
+ * Prints the number of unique states per depth, and the key sequence to the best (or deepest) state found.
+ */
+int main(int argc, char* argv[]) {
+    auto args = utils::parseArguments(argc, argv);
+    if (args.find(utils::CONSTANTS::HELP_KEY) != args.end()) {
+        std::cout << "Usage:" << std::endl << argv[0] << " --OPTIONAL FLAG=value" << std::endl << "Optional Flags:" << std::endl
+                << "--" << utils::CONSTANTS::FILE_PATH_KEY << "=path/to/rom" << std::endl
+                << "--" << utils::CONSTANTS::FRAMES_PER_STEP_KEY << "=frames a key is held before branching again" << std::endl
+                << "--" << utils::CONSTANTS::DEPTH_KEY << "=number of steps to search" << std::endl
+                << "--" << utils::CONSTANTS::BEAM_WIDTH_KEY << "=states kept every step // 0 for breadth first search" << std::endl
+                << "--" << utils::CONSTANTS::KEYS_KEY << "=comma separated keys to branch on // defaults to all 16" << std::endl
+                << "--" << utils::CONSTANTS::MEMORY_KEY << "=memory budget in MB" << std::endl
+                << "--" << utils::CONSTANTS::THREADS_KEY << "=worker threads // defaults to the number of cores" << std::endl
+                << "--" << utils::CONSTANTS::SCORE_ADDRESS_KEY << "=memory address whose value the beam maximizes" << std::endl
+                << "--" << utils::CONSTANTS::SEED_KEY << "=seed of the random numbers" << std::endl
+                << "Example : " << argv[0] << " --" << utils::CONSTANTS::FILE_PATH_KEY << "=" << utils::CONSTANTS::DEFAULT_FILE_PATH
+                << " --" << utils::CONSTANTS::KEYS_KEY << "=4,6 --" << utils::CONSTANTS::BEAM_WIDTH_KEY << "=1000" << std::endl;
+        return 0;
+    }
+
+    auto getArgument = [&args](const char* key, const std::string& defaultValue) {
+        return args.find(key) != args.end() ? args[key] : defaultValue;
+    };
+
+    Chip8 chip8;
+    chip8.loadFile(getArgument(utils::CONSTANTS::FILE_PATH_KEY, utils::CONSTANTS::DEFAULT_FILE_PATH).c_str());
+    chip8.setFPS(utils::CONSTANTS::DEFAULT_FPS);
+    chip8.setProcessorClockSpeed(std::stoi(getArgument(utils::CONSTANTS::CLOCK_SPEED_KEY, std::to_string(utils::CONSTANTS::DEFAULT_CLOCK_SPEED))));
+    // Every branch copies the random generator of its parent, so with a seed the whole search is reproducible
+    chip8.seedRandom(std::stoull(getArgument(utils::CONSTANTS::SEED_KEY, std::to_string(utils::CONSTANTS::DEFAULT_SEED))));
+
+    std::vector<int> keys;
+    if (args.find(utils::CONSTANTS::KEYS_KEY) != args.end()) {
+        keys = parseKeys(args[utils::CONSTANTS::KEYS_KEY]);
+    } else {
+        for (int key = 0; key < 16; key++) {
+            keys.push_back(key);
+        }
+    }
+
+    // Without a score address every state scores the same, so the beam keeps states by hash order
+    Explorer::ScoreFunction score = nullptr;
+    if (args.find(utils::CONSTANTS::SCORE_ADDRESS_KEY) != args.end()) {
+        uint16_t scoreAddress = std::stoul(args[utils::CONSTANTS::SCORE_ADDRESS_KEY], nullptr, 0) & 0xFFF;
+        score = [scoreAddress](const Chip8& state) {
+            return static_cast<double>(state.getMemory()[scoreAddress]);
+        };
+    }
+
+    const uint32_t maxDepth = std::stoul(getArgument(utils::CONSTANTS::DEPTH_KEY, std::to_string(utils::CONSTANTS::DEFAULT_DEPTH)));
+    Explorer explorer(
+        chip8,
+        keys,
+        std::stoul(getArgument(utils::CONSTANTS::FRAMES_PER_STEP_KEY, std::to_string(utils::CONSTANTS::DEFAULT_FRAMES_PER_STEP))),
+        std::stoull(getArgument(utils::CONSTANTS::BEAM_WIDTH_KEY, "0")),
+        std::stoull(getArgument(utils::CONSTANTS::MEMORY_KEY, std::to_string(utils::CONSTANTS::DEFAULT_MEMORY_MB))) * 1024 * 1024,
+        std::stoul(getArgument(utils::CONSTANTS::THREADS_KEY, std::to_string(std::thread::hardware_concurrency()))),
+        score
+    );
+
+    auto start = std::chrono::steady_clock::now();
+    while (explorer.getDepth() < maxDepth && explorer.step()) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "depth " << std::setw(4) << explorer.getDepth()
+                  << "  frontier " << std::setw(8) << explorer.getFrontierSize()
+                  << "  unique states " << std::setw(10) << explorer.getUniqueStates()
+                  << "  best score " << explorer.getBestScore()
+                  << "  " << std::fixed << std::setprecision(2) << elapsed.count() << "s" << std::defaultfloat << std::endl;
+    }
+
+    // Keys are printed in hex, "-" means no key was pressed during that step
+    std::cout << "Path:";
+    for (int key : explorer.getBestPath()) {
+        if (key == Explorer::NO_KEY) {
+            std::cout << " -";
+        } else {
+            std::cout << " " << std::hex << std::uppercase << key << std::dec;
+        }
+    }
+    std::cout << std::endl;
+    return 0;
+}
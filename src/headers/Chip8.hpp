@@ -2,6 +2,10 @@
 #define CHIP8_HPP
 #include <iostream>
 #include <chrono>
+#include <cstdint>
+#include "RandomGenerator.hpp"
+
+class TraceRecorder;
 
 class Chip8 {
 public:
@@ -14,6 +18,7 @@ public:
 
     bool shouldBeep() const;
     const bool (&getDisplay() const)[64][32];
+    const uint8_t (&getMemory() const)[4096];
 
     bool getDrawFlag();
 
@@ -23,6 +28,17 @@ public:
     uint16_t getProcessorClockSpeed() const;
     void setProcessorClockSpeed(const uint16_t clockSpeed);
 
+    uint64_t getCycleCount() const;
+    uint64_t getTimerWaitCycles() const;
+    uint64_t getDelayTimerWrites() const;
+    uint64_t getRomHash() const;
+    uint64_t hashState() const;
+
+    void setTracer(TraceRecorder* tracer);
+
+    void seedRandom(const uint64_t seed);
+    void setRandomMode(const RandomGenerator::Mode mode);
+
 
 
 private:
@@ -33,24 +49,39 @@ private:
     uint16_t addressRegister;
     uint16_t memoryStack[48];
     uint8_t stackPointer;
-    uint16_t delayTimer;
-    uint16_t soundTimer;
-    uint8_t timerPrecision;
+    uint8_t delayTimer;
+    uint8_t soundTimer;
+    uint64_t delayTimerSetCycle;
+    uint64_t soundTimerSetCycle;
+    uint64_t cycleCount;
+    uint16_t cycleRemainder;
     uint16_t processorClockSpeed;
     uint16_t fps;
     uint8_t timerFrequency;
     bool drawFlag;
     bool display[64][32];
+    TraceRecorder* tracer;
+    RandomGenerator randomGenerator;
+    uint64_t timerWaitCycles;
+    uint64_t delayTimerWrites;
+    uint64_t timerReadCycle;
+    uint16_t timerReadPc;
+    uint64_t jumpCycle;
+    uint64_t romHash;
 
     
     void readOpcode();
+    void executeOpcode();
     void clearDisplay();
     void throwOpcodeNotRecognisedError(const uint16_t opcode);
     uint8_t getRandomNumber();
     void draw(uint8_t Vx, uint8_t Vy, uint8_t n);
     void storeKey(uint8_t x);
+    void jump(uint16_t address);
     void registerDump(uint8_t x);
     void registerLoad(uint8_t x);
-    void updateTimers();
+    uint8_t getTimerValue(const uint8_t value, const uint64_t setCycle) const;
+    void recordTrace(const uint16_t tracedPc, const uint8_t (&tracedRegisters)[16]);
+    void rebaseTimer(uint8_t& value, uint64_t& setCycle, const uint16_t newClockSpeed);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef CLOCKGOVERNOR_HPP
+#define CLOCKGOVERNOR_HPP
+
+#include "Chip8.hpp"
+#include <string>
+#include <vector>
+
+class ClockGovernor {
+public:
+    ClockGovernor(const char* settingsPath, const uint64_t romHash, const uint16_t initialClockSpeed, const uint16_t minClockSpeed, const uint16_t maxClockSpeed);
+    void update(const Chip8& chip8);
+    uint16_t getClockSpeed() const;
+    void save() const;
+
+private:
+    const std::string SETTINGS_PATH;
+    const uint64_t ROM_HASH;
+    const uint16_t MIN_CLOCK_SPEED;
+    const uint16_t MAX_CLOCK_SPEED;
+    // Number of frames the timer-wait ratio is measured over before the clock speed is changed
+    static const uint16_t WINDOW_FRAMES = 30;
+    // A game that sets the delay timer but waits for it less than this is running slower than it should
+    static inline constexpr double LOW_WAIT_RATIO = 0.05;
+    // More waiting than this and cycles are being wasted
+    static inline constexpr double HIGH_WAIT_RATIO = 0.25;
+    // The learned clock speed is this percentile of the clock speeds used while the game was active
+    static inline constexpr double SAVED_PERCENTILE = 0.9;
+
+    uint16_t clockSpeed;
+    uint16_t windowFrame;
+    uint64_t windowStartCycle;
+    uint64_t windowStartTimerWaitCycles;
+    uint64_t windowStartDelayTimerWrites;
+    std::vector<uint16_t> activeClockSpeeds;
+};
+
+#endif
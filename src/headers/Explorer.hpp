@@ -0,0 +1,87 @@
+#ifndef EXPLORER_HPP
+#define EXPLORER_HPP
+
+#include "Chip8.hpp"
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Set of state hashes that can be used from many threads at once. 
+ * The hashes are split over shards with their own lock, so threads rarely wait for each other.
+ */
+class TranspositionTable {
+public:
+    TranspositionTable(const size_t maxEntries);
+    bool insert(const uint64_t hash);
+    size_t size() const;
+
+private:
+    static const size_t SHARD_COUNT = 64;
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_set<uint64_t> hashes;
+    };
+    std::array<Shard, SHARD_COUNT> shards;
+    const size_t MAX_ENTRIES_PER_SHARD;
+};
+
+/**
+ * Searches over input sequences. Every step, each state in the frontier is branched on every key in the key set
+ * (and on pressing nothing), and run for framesPerStep frames. States that were seen before are pruned.
+ * 
+ * With a beam width of 0 this is a breadth first search, limited only by the memory budget. Otherwise only the
+ * beamWidth best scoring states are kept every step.
+ * 
+ * States are told apart by Chip8::hashState, which covers everything that decides how the state runs on,
+ * so a pruned state would have behaved exactly like the one that was kept.
+ */
+class Explorer {
+public:
+    using ScoreFunction = std::function<double(const Chip8&)>;
+    static const int NO_KEY = -1;
+
+    Explorer(const Chip8& initialState, const std::vector<int>& keys, const uint32_t framesPerStep, const size_t beamWidth, 
+        const size_t memoryBudget, const unsigned int threadCount, const ScoreFunction& score = nullptr);
+    bool step();
+
+    uint32_t getDepth() const;
+    size_t getFrontierSize() const;
+    size_t getUniqueStates() const;
+    double getBestScore() const;
+    std::vector<int> getBestPath() const;
+
+private:
+    // A state in the frontier. historyIndex points to how we got here, so the frontier doesn't have to store the whole path.
+    struct Node {
+        Chip8 state;
+        uint64_t hash;
+        double score;
+        uint32_t historyIndex;
+    };
+    struct History {
+        uint32_t parent;
+        int8_t key;
+    };
+    static const uint32_t NO_PARENT = UINT32_MAX;
+
+    const std::vector<int> KEYS;
+    const uint32_t FRAMES_PER_STEP;
+    const size_t STATE_MEMORY;
+    const size_t MAX_FRONTIER_SIZE;
+    const unsigned int THREAD_COUNT;
+    const ScoreFunction SCORE;
+    TranspositionTable table;
+    std::vector<Node> frontier;
+    std::vector<History> history;
+    uint32_t depth;
+    double bestScore;
+    uint32_t bestHistoryIndex;
+    uint32_t deepestHistoryIndex;
+
+    void expand(const Node& parent, const int key, std::vector<Node>& children, std::vector<int>& childKeys, std::vector<uint32_t>& childParents);
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef GRIDRENDERER_HPP
+#define GRIDRENDERER_HPP
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Shown below every tile as two bars and a color for the display
+struct TileStatus {
+    double fps;
+    double instructionsPerSecond;
+    bool stalled;
+};
+
+class GridRenderer {
+public:
+    GridRenderer(const char* title, const int tileCount, const int windowWidth, const int windowHeight, const double targetFps, const double targetInstructionsPerSecond);
+    ~GridRenderer();
+    const bool checkRunning();
+    void handleEvents();
+    void updateTile(const int tile, const bool display[64][32], const TileStatus& status);
+    void render();
+    int getFocusedTile() const;
+
+    static const int NO_TILE = -1;
+
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    SDL_Texture* atlas;
+    bool isRunning;
+    const int TILE_COUNT;
+    const int COLUMNS;
+    const int ROWS;
+    const double TARGET_FPS;
+    const double TARGET_INSTRUCTIONS_PER_SECOND;
+    // Every tile is the 64x32 display, 2 rows of status bars and a 1 pixel gap to the next tile
+    static const int TILE_WIDTH = 64 + 1;
+    static const int TILE_HEIGHT = 32 + 2 + 1;
+    std::vector<uint32_t> pixels;
+    int focusedTile;
+
+    SDL_Rect getTileRect(const int tile) const;
+    SDL_Rect getDestinationRect(const SDL_Rect& source) const;
+    void drawBar(const int x, const int y, const double fraction, const uint32_t color);
+};
+
+#endif
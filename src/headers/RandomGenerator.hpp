@@ -0,0 +1,44 @@
+#ifndef RANDOMGENERATOR_HPP
+#define RANDOMGENERATOR_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Random byte generator used by CXNN. Every emulator has its own, so instances can be seeded (and copied) independently.
+ * Bytes are generated 64 at a time into a buffer, so most calls only read the next byte.
+ */
+class RandomGenerator {
+public:
+    enum class Mode {
+        XORSHIFT, // xorshift64*, fast and reproducible with a seed
+        LEGACY    // std::mt19937 through uniform_int_distribution(0, 255), like this emulator used to do. Reproducible with a seed and the same standard library.
+    };
+
+    RandomGenerator(const uint64_t seed, const Mode mode = Mode::XORSHIFT);
+    void seed(const uint64_t seed);
+    void setMode(const Mode mode);
+    Mode getMode() const;
+    uint64_t getState() const;
+    size_t getPosition() const;
+
+    inline uint8_t next() {
+        if (position == BUFFER_SIZE) {
+            refill();
+        }
+        return buffer[position++];
+    }
+
+    static Mode parseMode(const char* name);
+
+private:
+    static const size_t BUFFER_SIZE = 64;
+    Mode mode;
+    uint64_t state;
+    uint8_t buffer[BUFFER_SIZE];
+    size_t position;
+
+    void refill();
+};
+
+#endif
@@ -12,7 +12,7 @@ public:
     void render(const bool display[64][32]);
     void clear();
     const bool (&getKeyState() const)[16];
-    void setKeyState(bool* chip8Keyboard);
+    static void setKeyState(bool* chip8Keyboard);
     void playAudio(bool audioFlag);
     
 
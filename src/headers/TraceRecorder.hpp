@@ -0,0 +1,71 @@
+#ifndef TRACERECORDER_HPP
+#define TRACERECORDER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// A single executed instruction. Fixed size so the trace file can be read back without parsing.
+struct TraceRecord {
+    uint64_t cycle;
+    uint16_t pc;
+    uint16_t opcode;
+    uint16_t addressRegister;
+    uint8_t changedRegister; // index of the data register changed by the instruction, NO_REGISTER if none
+    uint8_t registerValue;   // value of the changed data register after the instruction
+
+    static const uint8_t NO_REGISTER = 0xFF;
+};
+static_assert(sizeof(TraceRecord) == 16, "Trace records are written to disk as is, they must stay 16 bytes");
+
+// Written at the start of every trace file. The dropped records are filled in when the recorder is closed.
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t droppedRecords;
+
+    static inline constexpr const char MAGIC[8] = { 'C', 'H', '8', 'T', 'R', 'A', 'C', 'E' };
+    static const uint32_t VERSION = 2;
+};
+
+class TraceRecorder {
+public:
+    TraceRecorder(const char* filePath, const size_t capacity = 1 << 16);
+    ~TraceRecorder();
+
+    /**
+     * Called by the emulator for every executed instruction. Never blocks, if the ring buffer is full the record is dropped.
+     * Records are stored by cycle, so a dropped record shows up as a missing cycle when the trace is read back.
+     * Must only be called from one thread.
+     */
+    inline void record(const TraceRecord& record) {
+        size_t head = this -> head.load(std::memory_order_relaxed);
+        if (head - tail.load(std::memory_order_acquire) == ring.size()) {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring[head & mask] = record;
+        this -> head.store(head + 1, std::memory_order_release);
+    }
+
+    uint64_t getDroppedRecords() const;
+
+private:
+    std::vector<TraceRecord> ring;
+    const size_t mask;
+    // The emulator only writes head, the flush thread only writes tail. Kept on separate cache lines so they don't slow each other down.
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::atomic<uint64_t> droppedRecords;
+    std::atomic<bool> isRunning;
+    std::ofstream file;
+    std::thread flushThread;
+
+    void flushLoop();
+    bool flush();
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include <map>
 #include <string>
 #include <cstdint>
+#include <iostream>
 
 class utils {
     public:
@@ -40,10 +41,59 @@ class utils {
         static inline constexpr const char* CLOCK_SPEED_KEY  = "clock_speed";
         static inline constexpr const char* FPS_KEY = "fps";
         static inline constexpr const char* HELP_KEY = "help";
+        static inline constexpr const char* TRACE_KEY = "trace";
+        static inline constexpr const char* SEED_KEY = "seed";
+        static inline constexpr const char* RNG_KEY = "rng";
+        static inline constexpr const char* PC_MIN_KEY = "pc_min";
+        static inline constexpr const char* PC_MAX_KEY = "pc_max";
+        static inline constexpr const char* OPCODE_KEY = "opcode";
+        static inline constexpr const char* OPCODE_MASK_KEY = "opcode_mask";
+        static inline constexpr const char* DIFF_KEY = "diff";
+        static inline constexpr const char* INSTANCES_KEY = "instances";
+        static inline constexpr const char* FRAMES_PER_STEP_KEY = "frames_per_step";
+        static inline constexpr const char* DEPTH_KEY = "depth";
+        static inline constexpr const char* BEAM_WIDTH_KEY = "beam_width";
+        static inline constexpr const char* KEYS_KEY = "keys";
+        static inline constexpr const char* MEMORY_KEY = "memory_mb";
+        static inline constexpr const char* SCORE_ADDRESS_KEY = "score_address";
+        static inline constexpr const char* GOVERNOR_KEY = "governor";
+        static inline constexpr const char* GOVERNOR_FILE_KEY = "governor_file";
+        static inline constexpr const char* MIN_CLOCK_SPEED_KEY = "min_clock_speed";
+        static inline constexpr const char* MAX_CLOCK_SPEED_KEY = "max_clock_speed";
+        static inline constexpr const char* ROM_DIR_KEY = "rom_dir";
+        static inline constexpr const char* GOLDEN_FILE_KEY = "golden";
+        static inline constexpr const char* BASELINE_FILE_KEY = "baseline";
+        static inline constexpr const char* INPUTS_FILE_KEY = "inputs";
+        static inline constexpr const char* FRAMES_KEY = "frames";
+        static inline constexpr const char* CHECKPOINT_KEY = "checkpoint";
+        static inline constexpr const char* THRESHOLD_KEY = "threshold";
+        static inline constexpr const char* THREADS_KEY = "threads";
+        static inline constexpr const char* UPDATE_KEY = "update";
+        static inline constexpr const char* UPDATE_BASELINE_KEY = "update_baseline";
+        static inline constexpr const char* BENCHMARK_MS_KEY = "benchmark_ms";
+        static inline constexpr const char* REPEATS_KEY = "repeats";
         
         static inline constexpr const char* DEFAULT_FILE_PATH = "../ROMS/BRIX.ch8";
         static const uint16_t DEFAULT_CLOCK_SPEED = 700;
         static const uint8_t DEFAULT_FPS = 60;
+        static const uint64_t DEFAULT_SEED = 0; // used by the tools that need reproducible runs
+        static const uint16_t DEFAULT_INSTANCES = 16;
+        static const uint32_t DEFAULT_FRAMES_PER_STEP = 10;
+        static const uint32_t DEFAULT_DEPTH = 30;
+        static const uint32_t DEFAULT_MEMORY_MB = 512;
+        static inline constexpr const char* DEFAULT_GOVERNOR_FILE = "clock_speeds.txt";
+        static const uint16_t DEFAULT_MIN_CLOCK_SPEED = 200;
+        static const uint16_t DEFAULT_MAX_CLOCK_SPEED = 2000;
+
+        static inline constexpr const char* DEFAULT_ROM_DIR = "../ROMS";
+        static inline constexpr const char* DEFAULT_GOLDEN_FILE = "../ROMS/golden.txt";
+        static inline constexpr const char* DEFAULT_BASELINE_FILE = "regress_baseline.txt";
+        static inline constexpr const char* DEFAULT_INPUTS_FILE = "../ROMS/inputs.txt";
+        static const uint32_t DEFAULT_FRAMES = 1800;
+        static const uint32_t DEFAULT_CHECKPOINT = 60;
+        static const uint8_t DEFAULT_THRESHOLD = 10;
+        static const uint32_t DEFAULT_BENCHMARK_MS = 500;
+        static const uint32_t DEFAULT_REPEATS = 5;
     };
 
     static void printHelp(char* argv[]) {
@@ -51,6 +101,13 @@ class utils {
                 <<  "--" << CONSTANTS::FILE_PATH_KEY << "=path/to/rom" << std::endl
                 <<  "--" << CONSTANTS::CLOCK_SPEED_KEY << "=clock speed // recomended to keep it below 1500" << std::endl
                 << "--" << CONSTANTS::FPS_KEY << "=FPS // max 255" << std::endl
+                << "--" << CONSTANTS::SEED_KEY << "=seed // makes the random numbers the same every run" << std::endl
+                << "--" << CONSTANTS::RNG_KEY << "=xorshift|legacy // legacy reproduces the old random number generation, both can be seeded" << std::endl
+                << "--" << CONSTANTS::GOVERNOR_KEY << " // adapt the clock speed to the ROM, starting from " << CONSTANTS::CLOCK_SPEED_KEY << std::endl
+                << "--" << CONSTANTS::GOVERNOR_FILE_KEY << "=path/to/file // where learned clock speeds are stored, defaults to " << CONSTANTS::DEFAULT_GOVERNOR_FILE << std::endl
+                << "--" << CONSTANTS::MIN_CLOCK_SPEED_KEY << "=lowest clock speed the governor may use" << std::endl
+                << "--" << CONSTANTS::MAX_CLOCK_SPEED_KEY << "=highest clock speed the governor may use" << std::endl
+                << "--" << CONSTANTS::TRACE_KEY << "=path/to/trace // records every executed instruction, read it with chip8_trace" << std::endl
                 << "Example : " << argv[0] << " --" << CONSTANTS::FILE_PATH_KEY << "=" <<  CONSTANTS::DEFAULT_FILE_PATH 
                 << " --" << CONSTANTS::FPS_KEY << "=" <<  (int) CONSTANTS::DEFAULT_FPS
                 << " --" << CONSTANTS::CLOCK_SPEED_KEY << "=" << (int) CONSTANTS::DEFAULT_CLOCK_SPEED << std::endl
@@ -1,8 +1,11 @@
 #include "SDLWrapper.hpp"
 #include "Chip8.hpp"
+#include "TraceRecorder.hpp"
 #include "utils.hpp"
+#include "ClockGovernor.hpp"
 #include <iostream>
 #include <thread>
+#include <memory>
 
 int main(int argc, char* argv[]) {
     auto args = utils::parseArguments(argc, argv);
@@ -36,6 +39,40 @@ int main(int argc, char* argv[]) {
         chip8.setProcessorClockSpeed(utils::CONSTANTS::DEFAULT_CLOCK_SPEED);
      }
 
+    // If a random number generator is provided, use it. If a seed is provided, the random numbers will be the same every run
+    if (args.find(utils::CONSTANTS::RNG_KEY) != args.end()) {
+        chip8.setRandomMode(RandomGenerator::parseMode(args[utils::CONSTANTS::RNG_KEY].c_str()));
+    }
+    if (args.find(utils::CONSTANTS::SEED_KEY) != args.end()) {
+        chip8.seedRandom(std::stoull(args[utils::CONSTANTS::SEED_KEY]));
+    }
+
+    // If a trace file is provided, record every executed instruction to it. The recorder must outlive the emulator loop.
+    std::unique_ptr<TraceRecorder> traceRecorder;
+    if (args.find(utils::CONSTANTS::TRACE_KEY) != args.end()) {
+        traceRecorder = std::make_unique<TraceRecorder>(args[utils::CONSTANTS::TRACE_KEY].c_str());
+        chip8.setTracer(traceRecorder.get());
+    }
+
+    // If the governor is enabled, it adapts the clock speed to the ROM. It starts from the clock speed learned in 
+    // previous sessions of this ROM, or from the clock speed set above if there is none.
+    std::unique_ptr<ClockGovernor> clockGovernor;
+    if (args.find(utils::CONSTANTS::GOVERNOR_KEY) != args.end()) {
+        auto getArgument = [&args](const char* key, const uint16_t defaultValue) {
+            return args.find(key) != args.end() ? static_cast<uint16_t>(std::stoi(args[key])) : defaultValue;
+        };
+        std::string settingsPath = args.find(utils::CONSTANTS::GOVERNOR_FILE_KEY) != args.end() ?
+            args[utils::CONSTANTS::GOVERNOR_FILE_KEY] : utils::CONSTANTS::DEFAULT_GOVERNOR_FILE;
+        clockGovernor = std::make_unique<ClockGovernor>(
+            settingsPath.c_str(),
+            chip8.getRomHash(),
+            chip8.getProcessorClockSpeed(),
+            getArgument(utils::CONSTANTS::MIN_CLOCK_SPEED_KEY, utils::CONSTANTS::DEFAULT_MIN_CLOCK_SPEED),
+            getArgument(utils::CONSTANTS::MAX_CLOCK_SPEED_KEY, utils::CONSTANTS::DEFAULT_MAX_CLOCK_SPEED)
+        );
+        chip8.setProcessorClockSpeed(clockGovernor -> getClockSpeed());
+    }
+
     // Initi SDL so that we can render + play audio
     SDLWrapper sdlWrapper(
         argv[1], 
@@ -73,7 +110,20 @@ int main(int argc, char* argv[]) {
         sdlWrapper.playAudio(chip8.shouldBeep());
 
         // Executes one frame. It will execute processorClockSpeed/fps instructions
-        chip8.executeFrame(); 
+        // If the ROM crashes we return instead of letting the exception escape, so that the trace recorder 
+        // gets destroyed and writes everything up to (and including) the faulting instruction
+        try {
+            chip8.executeFrame(); 
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        // Let the governor measure the frame and pick the clock speed for the next one
+        if (clockGovernor) {
+            clockGovernor -> update(chip8);
+            chip8.setProcessorClockSpeed(clockGovernor -> getClockSpeed());
+        }
         
         // Delay so that the desired FPS can be maintained
         frameTime = SDL_GetTicks() - frameStart;
@@ -82,6 +132,11 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Remember the learned clock speed for the next session of this ROM
+    if (clockGovernor) {
+        clockGovernor -> save();
+    }
+
     return 0;
 }
  
\ No newline at end of file
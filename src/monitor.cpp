@@ -0,0 +1,123 @@
+#include "GridRenderer.hpp"
+#include "SDLWrapper.hpp"
+#include "Chip8.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// What the monitor tracks for every emulator, the status is refreshed once every second
+struct Instance {
+    Chip8 chip8;
+    TileStatus status = { 0, 0, false };
+    uint32_t drawnFrames = 0;
+    uint64_t lastCycleCount = 0;
+    uint64_t lastStateHash = 0;
+    bool crashed = false;
+};
+
+/**
+ * Runs many emulators at once and shows all of their displays in one window.
+ * Below every display there is a fps bar (green, frames per second that changed the display) and an instructions/sec bar (blue).
+ * The display turns red when the emulator stalled, that is its state did not change in the last second or it crashed.
+ * Clicking a tile focuses it and sends the keyboard input to that emulator.
+ */
+int main(int argc, char* argv[]) {
+    auto args = utils::parseArguments(argc, argv);
+    if (args.find(utils::CONSTANTS::HELP_KEY) != args.end()) {
+        std::cout << "Usage:" << std::endl << argv[0] << " --OPTIONAL FLAG=value" << std::endl << "Optional Flags:" << std::endl
+                << "--" << utils::CONSTANTS::FILE_PATH_KEY << "=path/to/rom" << std::endl
+                << "--" << utils::CONSTANTS::INSTANCES_KEY << "=number of emulators to run" << std::endl
+                << "--" << utils::CONSTANTS::CLOCK_SPEED_KEY << "=clock speed of every emulator" << std::endl
+                << "--" << utils::CONSTANTS::FPS_KEY << "=FPS // max 255" << std::endl
+                << "Click a tile to focus it and control it with 1 2 3 4 q w e r a s d f z x c v, click again or press escape to go back" << std::endl;
+        return 0;
+    }
+
+    auto getArgument = [&args](const char* key, const int defaultValue) {
+        return args.find(key) != args.end() ? std::stoi(args[key]) : defaultValue;
+    };
+    const std::string filePath = args.find(utils::CONSTANTS::FILE_PATH_KEY) != args.end() ? args[utils::CONSTANTS::FILE_PATH_KEY] : utils::CONSTANTS::DEFAULT_FILE_PATH;
+    const int instanceCount = std::max(1, getArgument(utils::CONSTANTS::INSTANCES_KEY, utils::CONSTANTS::DEFAULT_INSTANCES));
+    const uint16_t fps = getArgument(utils::CONSTANTS::FPS_KEY, utils::CONSTANTS::DEFAULT_FPS);
+    const uint16_t clockSpeed = getArgument(utils::CONSTANTS::CLOCK_SPEED_KEY, utils::CONSTANTS::DEFAULT_CLOCK_SPEED);
+
+    // Chip8 is large (4KB of memory), so the instances live on the heap
+    std::vector<std::unique_ptr<Instance>> instances;
+    for (int i = 0; i < instanceCount; i++) {
+        auto instance = std::make_unique<Instance>();
+        instance -> chip8.loadFile(filePath.c_str());
+        instance -> chip8.setFPS(fps);
+        instance -> chip8.setProcessorClockSpeed(clockSpeed);
+        instances.push_back(std::move(instance));
+    }
+
+    GridRenderer gridRenderer("chip8 monitor", instanceCount, 1600, 900, fps, clockSpeed);
+
+    Uint32 frameDelay = 1000 / fps;
+    Uint32 statusStart = SDL_GetTicks();
+    while (gridRenderer.checkRunning()) {
+        Uint32 frameStart = SDL_GetTicks();
+        gridRenderer.handleEvents();
+
+        // Refresh the status of every instance once a second
+        bool updateStatus = frameStart - statusStart >= 1000;
+        double seconds = (frameStart - statusStart) / 1000.0;
+        if (updateStatus) {
+            statusStart = frameStart;
+        }
+
+        for (int i = 0; i < instanceCount; i++) {
+            Instance& instance = *instances[i];
+            Chip8& chip8 = instance.chip8;
+
+            // Only the focused instance gets keyboard input
+            if (i == gridRenderer.getFocusedTile()) {
+                SDLWrapper::setKeyState(chip8.keyboard);
+            } else {
+                std::fill(std::begin(chip8.keyboard), std::end(chip8.keyboard), false);
+            }
+
+            if (!instance.crashed) {
+                try {
+                    chip8.executeFrame();
+                } catch (const std::exception& e) {
+                    std::cerr << "Instance " << i << " crashed: " << e.what() << std::endl;
+                    instance.crashed = true;
+                }
+            }
+
+            // A frame counts towards the fps when it changed the display, however many sprites it drew
+            bool drawn = chip8.getDrawFlag();
+            if (drawn) {
+                ++instance.drawnFrames;
+            }
+
+            if (updateStatus) {
+                uint64_t stateHash = chip8.hashState();
+                instance.status.fps = instance.drawnFrames / seconds;
+                instance.status.instructionsPerSecond = (chip8.getCycleCount() - instance.lastCycleCount) / seconds;
+                instance.status.stalled = instance.crashed || stateHash == instance.lastStateHash;
+                instance.drawnFrames = 0;
+                instance.lastCycleCount = chip8.getCycleCount();
+                instance.lastStateHash = stateHash;
+            }
+
+            // Only copy the display into the atlas when something changed
+            if (drawn || updateStatus) {
+                gridRenderer.updateTile(i, chip8.getDisplay(), instance.status);
+            }
+        }
+
+        // One texture upload and one draw call for all instances
+        gridRenderer.render();
+
+        Uint32 frameTime = SDL_GetTicks() - frameStart;
+        if (frameDelay > frameTime) {
+            SDL_Delay(frameDelay - frameTime);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+#include "Chip8.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// A recorded key press or release that is applied before the given frame is executed
+struct InputEvent {
+    uint32_t frame;
+    uint8_t key;
+    bool pressed;
+};
+
+// What we know about a ROM, either from the golden/baseline files or from the current run
+struct RomResult {
+    std::string name;
+    std::vector<uint64_t> hashes;
+    double instructionsPerSecond = 0;
+    std::string error;
+};
+
+/**
+ * Reads the inputs manifest. Each line is "<rom name> <frame> <key in hex> <1 for press, 0 for release>".
+ * Empty lines and lines starting with # are ignored.
+ *
+ * @param const std::string& filePath - path to the manifest. A missing manifest means no inputs.
+ * @returns the input events of every ROM, sorted by frame
+ */
+std::map<std::string, std::vector<InputEvent>> loadInputs(const std::string& filePath) {
+    std::map<std::string, std::vector<InputEvent>> inputs;
+    std::ifstream file(filePath);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream stream(line);
+        std::string name;
+        uint32_t frame;
+        int key;
+        int pressed;
+        if (!(stream >> name >> frame >> std::hex >> key >> std::dec >> pressed) || key < 0 || key > 0xF) {
+            throw std::runtime_error("Invalid line in inputs manifest: " + line);
+        }
+        inputs[name].push_back({ frame, static_cast<uint8_t>(key), pressed != 0 });
+    }
+    for (auto& [name, events] : inputs) {
+        std::stable_sort(events.begin(), events.end(), [](const InputEvent& a, const InputEvent& b) { return a.frame < b.frame; });
+    }
+    return inputs;
+}
+
+/**
+ * Reads a results file. Each line is "<rom name> <instructions per second> <checkpoint hashes in hex...>".
+ * The golden file only uses the hashes, the baseline file only uses the instructions per second.
+ *
+ * @param const std::string& filePath - path to the results file. A missing file means no results.
+ * @returns the stored results, keyed by ROM name
+ */
+std::map<std::string, RomResult> loadResults(const std::string& filePath) {
+    std::map<std::string, RomResult> results;
+    std::ifstream file(filePath);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream stream(line);
+        RomResult result;
+        stream >> result.name >> result.instructionsPerSecond >> std::hex;
+        uint64_t hash;
+        while (stream >> hash) {
+            result.hashes.push_back(hash);
+        }
+        results[result.name] = result;
+    }
+    return results;
+}
+
+void saveResults(const std::string& filePath, const std::vector<RomResult>& results) {
+    std::ofstream file(filePath);
+    if (!file) {
+        throw std::runtime_error("Could not write " + filePath);
+    }
+    file << "# <rom name> <instructions per second> <state hash at every checkpoint>" << std::endl;
+    for (const RomResult& result : results) {
+        if (!result.error.empty()) {
+            continue;
+        }
+        file << result.name << " " << std::fixed << std::setprecision(0) << result.instructionsPerSecond << std::hex;
+        for (uint64_t hash : result.hashes) {
+            file << " " << std::setw(16) << std::setfill('0') << hash;
+        }
+        file << std::dec << std::endl;
+    }
+}
+
+/**
+ * Runs a single ROM headless for the given number of frames, applying the recorded inputs and seeding the random numbers.
+ * The state is hashed every checkpointInterval frames and once more at the end.
+ */
+RomResult runRom(const std::filesystem::path& romPath, const std::vector<InputEvent>& inputs, uint32_t frames, uint32_t checkpointInterval, uint64_t seed) {
+    RomResult result;
+    result.name = romPath.filename().string();
+    try {
+        Chip8 chip8;
+        chip8.loadFile(romPath.string().c_str());
+        chip8.setFPS(utils::CONSTANTS::DEFAULT_FPS);
+        chip8.setProcessorClockSpeed(utils::CONSTANTS::DEFAULT_CLOCK_SPEED);
+        // Seeded so that ROMs using CXNN reach the same states every run
+        chip8.seedRandom(seed);
+
+        size_t nextInput = 0;
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            while (nextInput < inputs.size() && inputs[nextInput].frame <= frame) {
+                chip8.keyboard[inputs[nextInput].key] = inputs[nextInput].pressed;
+                nextInput++;
+            }
+            chip8.executeFrame();
+            if ((frame + 1) % checkpointInterval == 0 || frame + 1 == frames) {
+                result.hashes.push_back(chip8.hashState());
+            }
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+/**
+ * Measures how many instructions per second a ROM runs at. The short run used for the hashes takes well under a millisecond,
+ * which is too short to time, so the ROM is run again unthrottled for at least minimumMilliseconds. 
+ * This is repeated and the best repeat is kept, since anything else running on the machine can only make a repeat slower.
+ * If the ROM crashes it is reloaded and the timing goes on, crashes are reported by the hash run.
+ *
+ * Must not run alongside other ROMs, or they would compete for the cores.
+ */
+double measureThroughput(const std::filesystem::path& romPath, uint64_t seed, uint32_t minimumMilliseconds, uint32_t repeats) {
+    double best = 0;
+    for (uint32_t repeat = 0; repeat < std::max(1u, repeats); repeat++) {
+        uint64_t cycles = 0;
+        std::chrono::duration<double> elapsed(0);
+        auto start = std::chrono::steady_clock::now();
+        while (elapsed.count() * 1000 < minimumMilliseconds) {
+            Chip8 chip8;
+            chip8.loadFile(romPath.string().c_str());
+            chip8.setFPS(utils::CONSTANTS::DEFAULT_FPS);
+            chip8.setProcessorClockSpeed(utils::CONSTANTS::DEFAULT_CLOCK_SPEED);
+            chip8.seedRandom(seed);
+            try {
+                // Check the clock every 1000 frames so that reading it does not show up in the measurement
+                while (elapsed.count() * 1000 < minimumMilliseconds) {
+                    for (uint32_t frame = 0; frame < 1000; frame++) {
+                        chip8.executeFrame();
+                    }
+                    elapsed = std::chrono::steady_clock::now() - start;
+                }
+            } catch (const std::exception&) {
+                elapsed = std::chrono::steady_clock::now() - start;
+            }
+            cycles += chip8.getCycleCount();
+        }
+        best = std::max(best, cycles / elapsed.count());
+    }
+    return best;
+}
+
+/**
+ * Runs every ROM in the ROM directory headless on all cores and compares the state hashes against the golden file.
+ * Then times every ROM on its own and compares the throughput against the previous baseline.
+ *
+ * Exits with 1 if any ROM diverged from the golden file, failed, is missing from the ROM directory, or got slower than the threshold allows.
+ * Nothing is written when a ROM failed or no ROM matches the golden file. Updating only the baseline never hides a divergence.
+ */
+int main(int argc, char* argv[]) {
+    auto args = utils::parseArguments(argc, argv);
+    auto getArgument = [&args](const char* key, const std::string& defaultValue) {
+        return args.find(key) != args.end() ? args[key] : defaultValue;
+    };
+
+    if (args.find(utils::CONSTANTS::HELP_KEY) != args.end()) {
+        std::cout << "Usage:" << std::endl << argv[0] << " --OPTIONAL FLAG=value" << std::endl << "Optional Flags:" << std::endl
+                << "--" << utils::CONSTANTS::ROM_DIR_KEY << "=directory containing the .ch8 ROMs" << std::endl
+                << "--" << utils::CONSTANTS::GOLDEN_FILE_KEY << "=path to the golden hash file" << std::endl
+                << "--" << utils::CONSTANTS::BASELINE_FILE_KEY << "=path to the instructions/sec baseline file" << std::endl
+                << "--" << utils::CONSTANTS::INPUTS_FILE_KEY << "=path to the recorded inputs manifest" << std::endl
+                << "--" << utils::CONSTANTS::FRAMES_KEY << "=frames to run every ROM for" << std::endl
+                << "--" << utils::CONSTANTS::CHECKPOINT_KEY << "=frames between state hashes" << std::endl
+                << "--" << utils::CONSTANTS::THRESHOLD_KEY << "=allowed instructions/sec regression in percent" << std::endl
+                << "--" << utils::CONSTANTS::THREADS_KEY << "=worker threads // defaults to the number of cores" << std::endl
+                << "--" << utils::CONSTANTS::SEED_KEY << "=seed of the random numbers // the golden file is only valid for the seed it was made with" << std::endl
+                << "--" << utils::CONSTANTS::BENCHMARK_MS_KEY << "=milliseconds every ROM is timed for" << std::endl
+                << "--" << utils::CONSTANTS::REPEATS_KEY << "=times every ROM is timed, the best is kept" << std::endl
+                << "--" << utils::CONSTANTS::UPDATE_KEY << " // write the current results as the new golden file and baseline" << std::endl
+                << "--" << utils::CONSTANTS::UPDATE_BASELINE_KEY << " // only write the instructions/sec baseline, divergences still fail" << std::endl;
+        return 0;
+    }
+
+    const std::string goldenPath = getArgument(utils::CONSTANTS::GOLDEN_FILE_KEY, utils::CONSTANTS::DEFAULT_GOLDEN_FILE);
+    const std::string baselinePath = getArgument(utils::CONSTANTS::BASELINE_FILE_KEY, utils::CONSTANTS::DEFAULT_BASELINE_FILE);
+    const uint32_t frames = std::stoul(getArgument(utils::CONSTANTS::FRAMES_KEY, std::to_string(utils::CONSTANTS::DEFAULT_FRAMES)));
+    const uint32_t checkpointInterval = std::max(1ul, std::stoul(getArgument(utils::CONSTANTS::CHECKPOINT_KEY, std::to_string(utils::CONSTANTS::DEFAULT_CHECKPOINT))));
+    const double threshold = std::stod(getArgument(utils::CONSTANTS::THRESHOLD_KEY, std::to_string(utils::CONSTANTS::DEFAULT_THRESHOLD)));
+    const bool update = args.find(utils::CONSTANTS::UPDATE_KEY) != args.end();
+    const bool updateBaseline = update || args.find(utils::CONSTANTS::UPDATE_BASELINE_KEY) != args.end();
+    const uint32_t benchmarkMilliseconds = std::stoul(getArgument(utils::CONSTANTS::BENCHMARK_MS_KEY, std::to_string(utils::CONSTANTS::DEFAULT_BENCHMARK_MS)));
+    const uint32_t repeats = std::stoul(getArgument(utils::CONSTANTS::REPEATS_KEY, std::to_string(utils::CONSTANTS::DEFAULT_REPEATS)));
+    const uint64_t seed = std::stoull(getArgument(utils::CONSTANTS::SEED_KEY, std::to_string(utils::CONSTANTS::DEFAULT_SEED)));
+
+    std::vector<std::filesystem::path> roms;
+    for (const auto& entry : std::filesystem::directory_iterator(getArgument(utils::CONSTANTS::ROM_DIR_KEY, utils::CONSTANTS::DEFAULT_ROM_DIR))) {
+        if (entry.is_regular_file() && entry.path().extension() == ".ch8") {
+            roms.push_back(entry.path());
+        }
+    }
+    std::sort(roms.begin(), roms.end());
+
+    auto inputs = loadInputs(getArgument(utils::CONSTANTS::INPUTS_FILE_KEY, utils::CONSTANTS::DEFAULT_INPUTS_FILE));
+    auto golden = loadResults(goldenPath);
+    auto baseline = loadResults(baselinePath);
+
+    // Every worker picks the next ROM that has not been run yet, until none are left
+    std::vector<RomResult> results(roms.size());
+    std::atomic<size_t> nextRom = 0;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    if (args.find(utils::CONSTANTS::THREADS_KEY) != args.end()) {
+        threadCount = std::stoul(args[utils::CONSTANTS::THREADS_KEY]);
+    }
+    threadCount = std::clamp<unsigned int>(threadCount, 1, std::max<size_t>(roms.size(), 1));
+    const std::vector<InputEvent> noInputs;
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back([&]() {
+            for (size_t rom = nextRom++; rom < roms.size(); rom = nextRom++) {
+                auto romInputs = inputs.find(roms[rom].filename().string());
+                results[rom] = runRom(roms[rom], romInputs != inputs.end() ? romInputs->second : noInputs, frames, checkpointInterval, seed);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Timed one ROM at a time, after the hash run, so the ROMs don't compete for the cores
+    for (size_t rom = 0; rom < roms.size(); rom++) {
+        if (results[rom].error.empty()) {
+            results[rom].instructionsPerSecond = measureThroughput(roms[rom], seed, benchmarkMilliseconds, repeats);
+        }
+    }
+
+    bool failed = false;
+    bool errored = false;
+    for (const RomResult& result : results) {
+        std::cout << std::left << std::setw(24) << result.name;
+        if (!result.error.empty()) {
+            std::cout << "ERROR    " << result.error << std::endl;
+            failed = true;
+            errored = true;
+            continue;
+        }
+
+        auto goldenResult = golden.find(result.name);
+        if (goldenResult == golden.end()) {
+            std::cout << "NEW      ";
+        } else if (goldenResult->second.hashes != result.hashes) {
+            auto mismatch = std::mismatch(result.hashes.begin(), result.hashes.end(), goldenResult->second.hashes.begin(), goldenResult->second.hashes.end());
+            size_t checkpoint = mismatch.first - result.hashes.begin();
+            std::cout << "DIVERGED at checkpoint " << checkpoint << " ";
+            if (!update) {
+                failed = true;
+            }
+        } else {
+            std::cout << "OK       ";
+        }
+
+        std::cout << std::fixed << std::setprecision(0) << result.instructionsPerSecond << " ips";
+        auto baselineResult = baseline.find(result.name);
+        if (baselineResult != baseline.end() && baselineResult->second.instructionsPerSecond > 0) {
+            double delta = (result.instructionsPerSecond / baselineResult->second.instructionsPerSecond - 1) * 100;
+            std::cout << " (" << std::showpos << std::setprecision(1) << delta << std::noshowpos << "%)";
+            if (delta < -threshold && !updateBaseline) {
+                std::cout << " REGRESSION";
+                failed = true;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    // A golden entry without a ROM means the ROM was deleted or renamed, or the ROM directory is wrong
+    size_t matched = 0;
+    for (const auto& [name, goldenResult] : golden) {
+        auto result = std::find_if(results.begin(), results.end(), [&name](const RomResult& result) { return result.name == name; });
+        if (result != results.end()) {
+            matched++;
+            continue;
+        }
+        std::cout << std::left << std::setw(24) << name << "MISSING" << std::endl;
+        if (!update) {
+            failed = true;
+        }
+    }
+    if (!golden.empty() && matched == 0) {
+        std::cout << "No ROM matches the golden file, is the ROM directory right?" << std::endl;
+        failed = true;
+        errored = true;
+    }
+
+    if (errored && updateBaseline) {
+        std::cout << "Not updating anything, a ROM failed" << std::endl;
+    } else if (update) {
+        saveResults(goldenPath, results);
+        saveResults(baselinePath, results);
+        std::cout << "Updated " << goldenPath << " and " << baselinePath << std::endl;
+    } else if (updateBaseline) {
+        saveResults(baselinePath, results);
+        std::cout << "Updated " << baselinePath << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+#include "TraceRecorder.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+// Only records that match every condition are printed or compared
+struct TraceFilter {
+    uint16_t pcMin = 0;
+    uint16_t pcMax = 0xFFFF;
+    uint16_t opcode = 0;
+    uint16_t opcodeMask = 0;
+
+    bool matches(const TraceRecord& record) const {
+        return record.pc >= pcMin && record.pc <= pcMax && (record.opcode & opcodeMask) == (opcode & opcodeMask);
+    }
+};
+
+// Cycles [start, end) that are missing from a trace because the recorder dropped them
+struct TraceGap {
+    uint64_t start;
+    uint64_t end;
+};
+
+/**
+ * Reads trace records in batches, so that traces that don't fit in memory can still be decoded.
+ * Every executed instruction is recorded with its cycle, so a cycle that is skipped means the recorder dropped records there.
+ */
+class TraceReader {
+public:
+    TraceReader(const std::string& filePath, const TraceFilter& filter) : file(filePath, std::ios::binary), filter(filter), buffer(4096), position(0), size(0),
+        nextCycle(0), started(false), ended(false), missingRecords(0) {
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw std::runtime_error("Could not read trace file " + filePath);
+        }
+        if (std::memcmp(header.magic, TraceFileHeader::MAGIC, sizeof(header.magic)) != 0 || header.version != TraceFileHeader::VERSION
+                || header.recordSize != sizeof(TraceRecord)) {
+            throw std::runtime_error(filePath + " is not a trace file, or was written by an incompatible version.");
+        }
+    }
+
+    /**
+     * @param TraceRecord& record - set to the next record that matches the filter
+     * @returns false when there are no more records
+     */
+    bool next(TraceRecord& record) {
+        gaps.clear();
+        while (true) {
+            if (position == size) {
+                file.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(TraceRecord));
+                size = file.gcount() / sizeof(TraceRecord);
+                position = 0;
+                if (size == 0) {
+                    ended = true;
+                    return false;
+                }
+            }
+            record = buffer[position++];
+            if (started && record.cycle > nextCycle) {
+                gaps.push_back({ nextCycle, record.cycle });
+                missingRecords += record.cycle - nextCycle;
+            }
+            started = true;
+            nextCycle = record.cycle + 1;
+            if (filter.matches(record)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @returns the gaps between the previous record returned by next and the current one
+     */
+    const std::vector<TraceGap>& getGaps() const {
+        return gaps;
+    }
+
+    /**
+     * @returns true if the record of the cycle was dropped, either in one of the current gaps or at the end of the trace
+     */
+    bool isMissing(const uint64_t cycle) const {
+        if (ended && cycle >= nextCycle && cycle - nextCycle < getUnaccountedDrops()) {
+            return true;
+        }
+        return std::any_of(gaps.begin(), gaps.end(), [cycle](const TraceGap& gap) { return cycle >= gap.start && cycle < gap.end; });
+    }
+
+    /**
+     * Records dropped after the last record in the file leave no gap, only the recorder knows about them.
+     * 
+     * @returns the records the recorder dropped that no gap read so far accounts for
+     */
+    uint64_t getUnaccountedDrops() const {
+        return header.droppedRecords > missingRecords ? header.droppedRecords - missingRecords : 0;
+    }
+
+private:
+    std::ifstream file;
+    const TraceFilter filter;
+    TraceFileHeader header;
+    std::vector<TraceRecord> buffer;
+    size_t position;
+    size_t size;
+    uint64_t nextCycle;
+    bool started;
+    bool ended;
+    uint64_t missingRecords;
+    std::vector<TraceGap> gaps;
+};
+
+void printGaps(const TraceReader& reader, const char* prefix = "") {
+    for (const TraceGap& gap : reader.getGaps()) {
+        std::cout << prefix << std::dec << "-- " << gap.end - gap.start << " records dropped (cycles " << gap.start << " to " << gap.end - 1 << ") --" << std::endl;
+    }
+}
+
+void printRecord(const TraceRecord& record, const char* prefix = "") {
+    std::cout << prefix << std::dec << std::setfill(' ') << std::setw(12) << record.cycle << std::hex << std::setfill('0')
+              << "  pc=" << std::setw(3) << record.pc
+              << "  op=" << std::setw(4) << record.opcode
+              << "  I=" << std::setw(3) << record.addressRegister;
+    if (record.changedRegister != TraceRecord::NO_REGISTER) {
+        std::cout << "  V" << (int) record.changedRegister << "=" << std::setw(2) << (int) record.registerValue;
+    }
+    std::cout << std::dec << std::endl;
+}
+
+bool operator==(const TraceRecord& a, const TraceRecord& b) {
+    return a.cycle == b.cycle && a.pc == b.pc && a.opcode == b.opcode && a.addressRegister == b.addressRegister
+        && a.changedRegister == b.changedRegister && (a.changedRegister == TraceRecord::NO_REGISTER || a.registerValue == b.registerValue);
+}
+
+/**
+ * Compares two traces record by record, cycle included, and prints the first record where they diverge.
+ * A record whose cycle the other trace dropped cannot be compared, so it is skipped instead of reported as a divergence.
+ *
+ * @returns 0 if the traces are the same, 1 otherwise
+ */
+int diffTraces(TraceReader& first, TraceReader& second) {
+    TraceRecord a;
+    TraceRecord b;
+    uint64_t compared = 0;
+    uint64_t skipped = 0;
+    bool hasA = first.next(a);
+    bool hasB = second.next(b);
+    while (true) {
+        if (!hasA && !hasB) {
+            std::cout << "Traces are identical (" << compared << " records";
+            if (skipped > 0) {
+                std::cout << ", " << skipped << " skipped because the other trace dropped them";
+            }
+            std::cout << ")" << std::endl;
+            return 0;
+        }
+        if (hasA && (!hasB || a.cycle < b.cycle) && second.isMissing(a.cycle)) {
+            skipped++;
+            hasA = first.next(a);
+            continue;
+        }
+        if (hasB && (!hasA || b.cycle < a.cycle) && first.isMissing(b.cycle)) {
+            skipped++;
+            hasB = second.next(b);
+            continue;
+        }
+        if (hasA != hasB || !(a == b)) {
+            std::cout << "Traces diverge after " << compared << " matching records" << std::endl;
+            if (hasA) {
+                printRecord(a, "< ");
+            }
+            if (hasB) {
+                printRecord(b, "> ");
+            }
+            return 1;
+        }
+        compared++;
+        hasA = first.next(a);
+        hasB = second.next(b);
+    }
+}
+
+/**
+ * Decodes a trace written with the --trace flag of chip8. Records can be filtered by pc range and opcode,
+ * and two traces can be diffed to find where the executions diverged.
+ */
+int main(int argc, char* argv[]) {
+    auto args = utils::parseArguments(argc, argv);
+    if (args.find(utils::CONSTANTS::HELP_KEY) != args.end() || args.find(utils::CONSTANTS::FILE_PATH_KEY) == args.end()) {
+        std::cout << "Usage:" << std::endl << argv[0] << " --" << utils::CONSTANTS::FILE_PATH_KEY << "=path/to/trace --OPTIONAL FLAG=value" << std::endl
+                << "Optional Flags:" << std::endl
+                << "--" << utils::CONSTANTS::PC_MIN_KEY << "=lowest pc to show" << std::endl
+                << "--" << utils::CONSTANTS::PC_MAX_KEY << "=highest pc to show" << std::endl
+                << "--" << utils::CONSTANTS::OPCODE_KEY << "=only show this opcode // combine with " << utils::CONSTANTS::OPCODE_MASK_KEY << std::endl
+                << "--" << utils::CONSTANTS::OPCODE_MASK_KEY << "=bits of the opcode to compare // defaults to 0xFFFF when an opcode is given" << std::endl
+                << "--" << utils::CONSTANTS::DIFF_KEY << "=path/to/other/trace // print the first record where the two traces diverge" << std::endl
+                << "Example : " << argv[0] << " --" << utils::CONSTANTS::FILE_PATH_KEY << "=brix.trace --"
+                << utils::CONSTANTS::OPCODE_KEY << "=0xD000 --" << utils::CONSTANTS::OPCODE_MASK_KEY << "=0xF000" << std::endl;
+        return 0;
+    }
+
+    // Values can be given in hex (0x200) or decimal
+    TraceFilter filter;
+    if (args.find(utils::CONSTANTS::PC_MIN_KEY) != args.end()) {
+        filter.pcMin = std::stoul(args[utils::CONSTANTS::PC_MIN_KEY], nullptr, 0);
+    }
+    if (args.find(utils::CONSTANTS::PC_MAX_KEY) != args.end()) {
+        filter.pcMax = std::stoul(args[utils::CONSTANTS::PC_MAX_KEY], nullptr, 0);
+    }
+    if (args.find(utils::CONSTANTS::OPCODE_KEY) != args.end()) {
+        filter.opcode = std::stoul(args[utils::CONSTANTS::OPCODE_KEY], nullptr, 0);
+        filter.opcodeMask = 0xFFFF;
+    }
+    if (args.find(utils::CONSTANTS::OPCODE_MASK_KEY) != args.end()) {
+        filter.opcodeMask = std::stoul(args[utils::CONSTANTS::OPCODE_MASK_KEY], nullptr, 0);
+    }
+
+    try {
+        TraceReader reader(args[utils::CONSTANTS::FILE_PATH_KEY], filter);
+        if (args.find(utils::CONSTANTS::DIFF_KEY) != args.end()) {
+            TraceReader other(args[utils::CONSTANTS::DIFF_KEY], filter);
+            return diffTraces(reader, other);
+        }
+
+        TraceRecord record;
+        while (reader.next(record)) {
+            printGaps(reader);
+            printRecord(record);
+        }
+        if (reader.getUnaccountedDrops() > 0) {
+            std::cout << "-- " << reader.getUnaccountedDrops() << " records dropped at the end --" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}